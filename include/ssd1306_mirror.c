@@ -0,0 +1,138 @@
+#include <string.h>
+#include "pico/stdio_usb.h"
+#include "ssd1306_mirror.h"
+
+static size_t keyframe_payload_size(size_t fbsize) {
+  size_t runs = (fbsize + SSD1306_MIRROR_MAX_RUN - 1) / SSD1306_MIRROR_MAX_RUN;
+  return fbsize + runs * SSD1306_MIRROR_RUN_HEADER_SIZE;
+}
+
+static uint8_t *put_run(uint8_t *out, const uint8_t *frame, size_t start, size_t len) {
+  *out++ = start & 0xFF;
+  *out++ = start >> 8;
+  *out++ = len;
+  memcpy(out, frame + start, len);
+  return out + len;
+}
+
+static uint16_t fletcher16(const uint8_t *data, size_t len) {
+  uint16_t sum1 = 0, sum2 = 0;
+  while (len--) {
+    sum1 = (sum1 + *data++) % 255;
+    sum2 = (sum2 + sum1) % 255;
+  }
+  return (sum2 << 8) | sum1;
+}
+
+void ssd1306_mirror_init(ssd1306_mirror_t *mirror, ssd1306_t *ssd, uint32_t interval_ms, uint32_t keyframe_interval_ms) {
+  mirror->width = ssd->width;
+  mirror->pages = ssd->pages;
+  mirror->fbsize = ssd->bufsize - 1;
+  mirror->packet_size = SSD1306_MIRROR_HEADER_SIZE + keyframe_payload_size(mirror->fbsize) + SSD1306_MIRROR_CHECKSUM_SIZE;
+  mirror->shadow = calloc(mirror->fbsize, sizeof(uint8_t));
+  mirror->packet = calloc(mirror->packet_size, sizeof(uint8_t));
+  mirror->seq = 0;
+  mirror->enabled = false;
+  mirror->interval_ms = interval_ms;
+  mirror->keyframe_interval_ms = keyframe_interval_ms;
+  mirror->next_frame = get_absolute_time();
+  mirror->next_keyframe = mirror->next_frame;
+}
+
+// Monta em mirror->packet o pacote com as diferenças entre o ram_buffer e o
+// último quadro espelhado. Retorna o tamanho do pacote, ou 0 se nada mudou.
+// Se as diferenças ocuparem mais que um quadro completo, envia o quadro completo.
+size_t ssd1306_mirror_encode(ssd1306_mirror_t *mirror, const ssd1306_t *ssd, bool keyframe) {
+  const uint8_t *frame = ssd->ram_buffer + 1;
+  uint8_t *payload = mirror->packet + SSD1306_MIRROR_HEADER_SIZE;
+  uint8_t *limit = payload + keyframe_payload_size(mirror->fbsize);
+  uint8_t *out = payload;
+
+  if (!keyframe) {
+    if (memcmp(frame, mirror->shadow, mirror->fbsize) == 0)
+      return 0;
+
+    size_t i = 0;
+    while (i < mirror->fbsize) {
+      if (frame[i] == mirror->shadow[i]) {
+        ++i;
+        continue;
+      }
+      size_t start = i, end = i + 1;
+      for (size_t j = i + 1; j < mirror->fbsize && j < start + SSD1306_MIRROR_MAX_RUN; ++j) {
+        if (frame[j] != mirror->shadow[j])
+          end = j + 1;
+        else if (j + 1 - end >= SSD1306_MIRROR_MERGE_GAP)
+          break;
+      }
+      if (out + SSD1306_MIRROR_RUN_HEADER_SIZE + (end - start) >= limit) {
+        keyframe = true;
+        break;
+      }
+      out = put_run(out, frame, start, end - start);
+      i = end;
+    }
+  }
+
+  if (keyframe) {
+    out = payload;
+    for (size_t start = 0; start < mirror->fbsize; start += SSD1306_MIRROR_MAX_RUN) {
+      size_t len = mirror->fbsize - start;
+      if (len > SSD1306_MIRROR_MAX_RUN)
+        len = SSD1306_MIRROR_MAX_RUN;
+      out = put_run(out, frame, start, len);
+    }
+  }
+
+  size_t payload_len = out - payload;
+  uint8_t *header = mirror->packet;
+  header[0] = SSD1306_MIRROR_MAGIC_0;
+  header[1] = SSD1306_MIRROR_MAGIC_1;
+  header[2] = mirror->seq++;
+  header[3] = keyframe ? SSD1306_MIRROR_FLAG_KEYFRAME : 0;
+  header[4] = mirror->width;
+  header[5] = mirror->pages;
+  header[6] = payload_len & 0xFF;
+  header[7] = payload_len >> 8;
+
+  uint16_t checksum = fletcher16(header + 2, SSD1306_MIRROR_HEADER_SIZE - 2 + payload_len);
+  *out++ = checksum & 0xFF;
+  *out++ = checksum >> 8;
+
+  memcpy(mirror->shadow, frame, mirror->fbsize);
+  return out - mirror->packet;
+}
+
+// Trata um byte recebido do host. Ao ligar, o próximo pacote é um quadro
+// completo; repetir o comando com o espelhamento já ligado não tem efeito.
+void ssd1306_mirror_command(ssd1306_mirror_t *mirror, int command) {
+  if (command == SSD1306_MIRROR_CMD_ENABLE && !mirror->enabled) {
+    mirror->enabled = true;
+    mirror->next_keyframe = get_absolute_time();
+  } else if (command == SSD1306_MIRROR_CMD_DISABLE) {
+    mirror->enabled = false;
+  }
+}
+
+// Chamada após ssd1306_send_data. Limita a taxa de envio a um pacote a cada
+// interval_ms e escreve direto no driver USB, sem passar pela UART nem pela
+// conversão de CRLF do printf.
+void ssd1306_mirror_update(ssd1306_mirror_t *mirror, const ssd1306_t *ssd) {
+  if (!mirror->enabled || !time_reached(mirror->next_frame))
+    return;
+  mirror->next_frame = make_timeout_time_ms(mirror->interval_ms);
+
+  // Host desconectado (DTR baixo): espera um novo comando para voltar a enviar
+  if (!stdio_usb_connected()) {
+    mirror->enabled = false;
+    return;
+  }
+
+  size_t len = ssd1306_mirror_encode(mirror, ssd, time_reached(mirror->next_keyframe));
+  if (len == 0)
+    return;
+  if (mirror->packet[3] & SSD1306_MIRROR_FLAG_KEYFRAME)
+    mirror->next_keyframe = make_timeout_time_ms(mirror->keyframe_interval_ms);
+
+  stdio_usb.out_chars((const char *)mirror->packet, len);
+}
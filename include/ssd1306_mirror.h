@@ -0,0 +1,53 @@
+#ifndef SSD1306_MIRROR_H
+#define SSD1306_MIRROR_H
+
+#include "ssd1306.h"
+
+// Espelhamento do framebuffer do SSD1306 para o host via USB (CDC).
+//
+// Cada pacote carrega apenas as sequências de bytes do ram_buffer que mudaram
+// desde o último quadro espelhado. Formato (inteiros little-endian):
+//
+//   0xFE 0x4D | seq | flags | largura | páginas | tam_payload (u16)
+//   payload: { deslocamento (u16) | n (u8) | n bytes } ...
+//   fletcher16 (u16) sobre seq .. fim do payload
+//
+// O deslocamento indexa o ram_buffer sem o byte de controle 0x40, no modo de
+// endereçamento vertical usado pelo driver: deslocamento = x * páginas + página.
+// O byte 0xFE nunca aparece em texto UTF-8, então o host separa os pacotes das
+// mensagens do printf que compartilham a mesma porta.
+//
+// O espelhamento começa desligado, para não enviar binário a monitores seriais
+// comuns. O host liga com o byte SSD1306_MIRROR_CMD_ENABLE e desliga com
+// SSD1306_MIRROR_CMD_DISABLE; ao cair o DTR, o espelhamento também é desligado.
+// Nenhum dos dois bytes aparece em texto UTF-8 digitado no monitor.
+
+#define SSD1306_MIRROR_MAGIC_0 0xFE
+#define SSD1306_MIRROR_MAGIC_1 0x4D
+#define SSD1306_MIRROR_FLAG_KEYFRAME 0x01
+#define SSD1306_MIRROR_HEADER_SIZE 8
+#define SSD1306_MIRROR_RUN_HEADER_SIZE 3
+#define SSD1306_MIRROR_CHECKSUM_SIZE 2
+#define SSD1306_MIRROR_MAX_RUN 255
+// Lacunas menores que o cabeçalho de uma sequência são enviadas junto
+#define SSD1306_MIRROR_MERGE_GAP SSD1306_MIRROR_RUN_HEADER_SIZE
+#define SSD1306_MIRROR_CMD_ENABLE 0xFE
+#define SSD1306_MIRROR_CMD_DISABLE 0xFD
+
+typedef struct {
+  uint8_t *shadow;
+  uint8_t *packet;
+  size_t fbsize;
+  size_t packet_size;
+  uint8_t width, pages, seq;
+  bool enabled;
+  uint32_t interval_ms, keyframe_interval_ms;
+  absolute_time_t next_frame, next_keyframe;
+} ssd1306_mirror_t;
+
+void ssd1306_mirror_init(ssd1306_mirror_t *mirror, ssd1306_t *ssd, uint32_t interval_ms, uint32_t keyframe_interval_ms);
+size_t ssd1306_mirror_encode(ssd1306_mirror_t *mirror, const ssd1306_t *ssd, bool keyframe);
+void ssd1306_mirror_command(ssd1306_mirror_t *mirror, int command);
+void ssd1306_mirror_update(ssd1306_mirror_t *mirror, const ssd1306_t *ssd);
+
+#endif
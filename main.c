@@ -7,6 +7,7 @@
 #include "hardware/irq.h"
 #include "pico/bootrom.h"
 #include "ssd1306.h"
+#include "ssd1306_mirror.h"
 
 // ==================== Definições ====================
 #define PORTA_I2C i2c1
@@ -39,6 +40,12 @@
 // Tempo de debounce (ms)
 #define ATRASO_DEBOUNCE_MS 200
 
+// Espelhamento do display para o host via USB (0 remove do firmware). Mesmo
+// compilado, só envia dados depois que tools/ssd1306_mirror_host pede.
+#define ESPELHAR_DISPLAY 1
+#define INTERVALO_ESPELHO_MS 100
+#define INTERVALO_QUADRO_COMPLETO_MS 5000
+
 // ==================== Variáveis Globais ====================
 volatile bool pwm_ativado = true;       // Habilita/desabilita os PWM (botão A)
 volatile bool led_verde_ligado = false;   // Estado do LED verde (toggle pelo botão do joystick)
@@ -51,6 +58,9 @@ static absolute_time_t ultimo_tempo_interrupcao_botaoB = {0};
 
 // Objeto do display OLED
 ssd1306_t oled;
+#if ESPELHAR_DISPLAY
+ssd1306_mirror_t espelho;
+#endif
 
 // ==================== Rotina de Interrupção ====================
 void callback_gpio(uint pino, uint32_t eventos)
@@ -118,6 +128,9 @@ int main()
     ssd1306_config(&oled);
     ssd1306_fill(&oled, false);
     ssd1306_send_data(&oled);
+#if ESPELHAR_DISPLAY
+    ssd1306_mirror_init(&espelho, &oled, INTERVALO_ESPELHO_MS, INTERVALO_QUADRO_COMPLETO_MS);
+#endif
 
     // --------- Inicialização do ADC para o Joystick ---------
     adc_init();
@@ -282,6 +295,13 @@ int main()
         // Desenha o quadrado representando a posição do joystick
         ssd1306_rect(&oled, disp_x, disp_y, 8, 8, 1, true);
         ssd1306_send_data(&oled);
+#if ESPELHAR_DISPLAY
+        // Comandos de liga/desliga enviados pelo visualizador no host
+        int comando;
+        while ((comando = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+            ssd1306_mirror_command(&espelho, comando);
+        ssd1306_mirror_update(&espelho, &oled);
+#endif
 
         sleep_ms(20);
     }
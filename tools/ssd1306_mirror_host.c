@@ -0,0 +1,397 @@
+// Visualizador do espelho do display SSD1306 (roda no PC, não na placa).
+//
+// Lê a porta USB da placa, separa os pacotes de espelhamento (ver
+// include/ssd1306_mirror.h) das mensagens do printf e reconstrói o framebuffer.
+// A imagem é desenhada no terminal ou gravada como quadros PPM.
+//
+// Ao abrir uma porta serial, liga o espelhamento na placa (que começa
+// desligado) e o desliga ao sair.
+//
+// No terminal, a imagem fica fixa no topo e as mensagens de texto rolam em uma
+// região abaixo dela; o terminal precisa de ao menos 128 colunas e 34 linhas.
+// Com -p, as mensagens vão para o stderr.
+//
+// Compilação: cc -O2 -o ssd1306_mirror_host tools/ssd1306_mirror_host.c
+// Uso:        ssd1306_mirror_host [-p prefixo] [-e escala] [-q] [dispositivo]
+//
+//   -p prefixo  grava cada quadro em prefixo_00000.ppm, prefixo_00001.ppm, ...
+//   -e escala   fator de ampliação dos quadros PPM, de 1 a 64 (padrão 4)
+//   -q          descarta as mensagens de texto
+//
+// Sem dispositivo, lê da entrada padrão.
+
+#define _DEFAULT_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+// Mesmos valores de include/ssd1306_mirror.h
+#define MAGIC_0 0xFE
+#define MAGIC_1 0x4D
+#define FLAG_KEYFRAME 0x01
+#define HEADER_SIZE 8
+#define RUN_HEADER_SIZE 3
+#define CHECKSUM_SIZE 2
+#define CMD_ENABLE 0xFE
+#define CMD_DISABLE 0xFD
+
+#define MAX_PAGES 8
+#define MAX_FBSIZE (255 * MAX_PAGES)
+#define MAX_PAYLOAD 4096
+#define INPUT_SIZE (2 * (HEADER_SIZE + MAX_PAYLOAD + CHECKSUM_SIZE))
+#define MAX_PPM_SCALE 64
+#define MAX_LINE 256
+#define ENABLE_PERIOD_MS 1000
+
+typedef struct {
+  uint8_t fb[MAX_FBSIZE];
+  uint8_t width, pages, next_seq;
+  bool synced;
+  const char *ppm_prefix;
+  unsigned ppm_scale, ppm_count;
+  bool quiet;
+  unsigned image_rows;
+  char line[MAX_LINE];
+  size_t line_len;
+  unsigned utf8_pending;
+  bool line_ok, skip_line;
+  bool failed;
+} viewer_t;
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void on_signal(int sig) {
+  (void)sig;
+  interrupted = 1;
+}
+
+// No terminal o texto divide o stdout com a imagem, para manter a ordem das
+// sequências de escape
+static FILE *text_stream(const viewer_t *v) {
+  return v->ppm_prefix ? stderr : stdout;
+}
+
+static uint16_t fletcher16(const uint8_t *data, size_t len) {
+  uint16_t sum1 = 0, sum2 = 0;
+  while (len--) {
+    sum1 = (sum1 + *data++) % 255;
+    sum2 = (sum2 + sum1) % 255;
+  }
+  return (sum2 << 8) | sum1;
+}
+
+static bool get_pixel(const viewer_t *v, unsigned x, unsigned y) {
+  return v->fb[x * v->pages + (y >> 3)] & (1 << (y & 0b111));
+}
+
+// Desenha duas linhas de pixels por linha do terminal com meios-blocos. Na
+// primeira vez (ou se a altura mudar), limpa a tela e restringe a rolagem às
+// linhas abaixo da imagem; depois, redesenha sem mover o cursor do texto.
+static void render_terminal(viewer_t *v) {
+  static const char *cells[4] = {" ", "▀", "▄", "█"};
+  unsigned height = v->pages * 8U;
+  unsigned rows = height / 2;
+
+  if (v->image_rows != rows) {
+    // Com menos linhas que isso o terminal ignora a região de rolagem
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && (ws.ws_row < rows + 2 || ws.ws_col < v->width)) {
+      fprintf(stderr, "Terminal pequeno demais: %ux%u, são necessárias %ux%u (ou use -p)\n",
+              ws.ws_col, ws.ws_row, v->width, rows + 2);
+      v->failed = true;
+      interrupted = 1;
+      return;
+    }
+    printf("\x1b[2J\x1b[%u;r\x1b[%u;1H", rows + 1, rows + 1);
+    v->image_rows = rows;
+  }
+  fputs("\x1b" "7", stdout);
+  for (unsigned y = 0; y < height; y += 2) {
+    printf("\x1b[%u;1H\x1b[2K", y / 2 + 1);
+    for (unsigned x = 0; x < v->width; ++x)
+      fputs(cells[get_pixel(v, x, y) | (get_pixel(v, x, y + 1) << 1)], stdout);
+  }
+  fputs("\x1b" "8", stdout);
+  fflush(stdout);
+}
+
+// Devolve a rolagem à tela inteira mantendo o cursor no fim do texto
+static void restore_terminal(const viewer_t *v) {
+  if (v->image_rows)
+    fputs("\x1b" "7\x1b[r\x1b" "8", stdout);
+  fflush(stdout);
+}
+
+static void write_ppm(viewer_t *v) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s_%05u.ppm", v->ppm_prefix, v->ppm_count++);
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    perror(path);
+    return;
+  }
+
+  unsigned width = v->width * v->ppm_scale;
+  unsigned height = v->pages * 8U * v->ppm_scale;
+  fprintf(f, "P6\n%u %u\n255\n", width, height);
+  for (unsigned y = 0; y < height; ++y) {
+    for (unsigned x = 0; x < width; ++x) {
+      uint8_t c = get_pixel(v, x / v->ppm_scale, y / v->ppm_scale) ? 0xFF : 0x00;
+      uint8_t rgb[3] = {c, c, c};
+      fwrite(rgb, 1, sizeof(rgb), f);
+    }
+  }
+  fclose(f);
+}
+
+// Aplica um pacote já validado. Deltas só são aplicados sobre um quadro
+// conhecido: após perda de pacote, aguarda o próximo quadro completo.
+static bool apply_packet(viewer_t *v, const uint8_t *pkt, size_t payload_len) {
+  uint8_t seq = pkt[2], flags = pkt[3], width = pkt[4], pages = pkt[5];
+  const uint8_t *payload = pkt + HEADER_SIZE;
+  size_t fbsize = (size_t)width * pages;
+
+  if (width == 0 || pages == 0 || pages > MAX_PAGES)
+    return false;
+
+  if (flags & FLAG_KEYFRAME) {
+    v->width = width;
+    v->pages = pages;
+    v->synced = true;
+  } else if (!v->synced || seq != v->next_seq || width != v->width || pages != v->pages) {
+    if (v->synced && !v->quiet)
+      fprintf(text_stream(v), "[ESPELHO] pacote perdido, aguardando quadro completo\n");
+    v->synced = false;
+    return false;
+  }
+  v->next_seq = seq + 1;
+
+  size_t pos = 0;
+  while (pos + RUN_HEADER_SIZE <= payload_len) {
+    size_t offset = payload[pos] | (payload[pos + 1] << 8);
+    size_t len = payload[pos + 2];
+    pos += RUN_HEADER_SIZE;
+    if (pos + len > payload_len || offset + len > fbsize) {
+      v->synced = false;
+      return false;
+    }
+    memcpy(v->fb + offset, payload + pos, len);
+    pos += len;
+  }
+  return true;
+}
+
+static void reset_line(viewer_t *v) {
+  v->line_len = 0;
+  v->utf8_pending = 0;
+  v->line_ok = true;
+}
+
+// Após um pacote corrompido, descarta o texto até o fim da linha: o resto do
+// pacote chega aqui como se fosse texto
+static void discard_line(viewer_t *v) {
+  reset_line(v);
+  v->skip_line = true;
+}
+
+// Acumula o texto em linhas e só imprime as que são UTF-8 válido, sem
+// caracteres de controle
+static void emit_text(viewer_t *v, uint8_t c) {
+  if (c == '\n') {
+    if (!v->quiet && !v->skip_line && v->line_ok && v->utf8_pending == 0) {
+      fwrite(v->line, 1, v->line_len, text_stream(v));
+      fputc('\n', text_stream(v));
+    }
+    reset_line(v);
+    v->skip_line = false;
+    return;
+  }
+  if (c == '\r' || v->skip_line || !v->line_ok)
+    return;
+
+  if (v->utf8_pending) {
+    if ((c & 0xC0) == 0x80)
+      --v->utf8_pending;
+    else
+      v->line_ok = false;
+  } else if (c >= 0xC2 && c <= 0xDF) {
+    v->utf8_pending = 1;
+  } else if (c >= 0xE0 && c <= 0xEF) {
+    v->utf8_pending = 2;
+  } else if (c >= 0xF0 && c <= 0xF4) {
+    v->utf8_pending = 3;
+  } else if ((c < 0x20 && c != '\t') || c >= 0x7F) {
+    v->line_ok = false;
+  }
+
+  if (v->line_ok && v->line_len < MAX_LINE)
+    v->line[v->line_len++] = c;
+}
+
+// Consome o que for possível de buf e retorna quantos bytes foram usados
+static size_t process_input(viewer_t *v, const uint8_t *buf, size_t len) {
+  size_t pos = 0;
+
+  while (pos < len && !interrupted) {
+    if (buf[pos] != MAGIC_0) {
+      emit_text(v, buf[pos++]);
+      continue;
+    }
+    if (len - pos < HEADER_SIZE)
+      break;
+    size_t payload_len = buf[pos + 6] | (buf[pos + 7] << 8);
+    if (buf[pos + 1] != MAGIC_1 || payload_len > MAX_PAYLOAD) {
+      discard_line(v);
+      ++pos;
+      continue;
+    }
+    size_t total = HEADER_SIZE + payload_len + CHECKSUM_SIZE;
+    if (len - pos < total)
+      break;
+
+    const uint8_t *pkt = buf + pos;
+    uint16_t checksum = pkt[total - 2] | (pkt[total - 1] << 8);
+    if (fletcher16(pkt + 2, HEADER_SIZE - 2 + payload_len) != checksum) {
+      discard_line(v);
+      ++pos;
+      continue;
+    }
+    v->skip_line = false;
+
+    if (apply_packet(v, pkt, payload_len)) {
+      if (v->ppm_prefix)
+        write_ppm(v);
+      else
+        render_terminal(v);
+    }
+    pos += total;
+  }
+  fflush(text_stream(v));
+  return pos;
+}
+
+// Abre a porta sem bloquear e a põe em modo bruto (sem eco, sem controle de
+// fluxo por XON/XOFF nem conversão de fim de linha) antes de qualquer leitura,
+// descartando o que chegou enquanto ela ainda estava em modo canônico.
+// Arquivos gravados de uma captura também são aceitos, somente para leitura.
+static int open_input(const char *path) {
+  int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (fd < 0)
+    fd = open(path, O_RDONLY | O_NOCTTY | O_NONBLOCK);
+  if (fd < 0) {
+    perror(path);
+    return -1;
+  }
+
+  struct termios tio;
+  if (isatty(fd) && tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(fd, TCSANOW, &tio);
+    tcflush(fd, TCIFLUSH);
+  }
+  return fd;
+}
+
+static void send_command(int fd, uint8_t command) {
+  if (write(fd, &command, 1) != 1 && errno != EAGAIN)
+    perror("write");
+}
+
+static long long now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+static void print_usage(const char *prog) {
+  fprintf(stderr, "Uso: %s [-p prefixo] [-e escala] [-q] [dispositivo]\n", prog);
+}
+
+int main(int argc, char **argv) {
+  static viewer_t viewer = {.ppm_scale = 4, .line_ok = true};
+  unsigned long scale;
+  char *end;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "p:e:q")) != -1) {
+    switch (opt) {
+    case 'p':
+      viewer.ppm_prefix = optarg;
+      break;
+    case 'e':
+      scale = strtoul(optarg, &end, 10);
+      if (optarg[0] < '0' || optarg[0] > '9' || *end != '\0' || scale < 1 || scale > MAX_PPM_SCALE) {
+        fprintf(stderr, "Escala inválida: %s (use de 1 a %d)\n", optarg, MAX_PPM_SCALE);
+        print_usage(argv[0]);
+        return 1;
+      }
+      viewer.ppm_scale = scale;
+      break;
+    case 'q':
+      viewer.quiet = true;
+      break;
+    default:
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+
+  int fd = STDIN_FILENO;
+  if (optind < argc && (fd = open_input(argv[optind])) < 0)
+    return 1;
+
+  // Sem SA_RESTART: o Ctrl+C interrompe o poll e o terminal é restaurado
+  struct sigaction sa = {.sa_handler = on_signal};
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+
+  // O comando de ligar é repetido periodicamente; na placa, repeti-lo com o
+  // espelhamento já ligado não tem efeito
+  bool serial = isatty(fd) && fd != STDIN_FILENO;
+  long long next_enable = 0;
+
+  static uint8_t buf[INPUT_SIZE];
+  struct pollfd pfd = {.fd = fd, .events = POLLIN};
+  size_t len = 0;
+  while (!interrupted) {
+    if (serial && now_ms() >= next_enable) {
+      send_command(fd, CMD_ENABLE);
+      next_enable = now_ms() + ENABLE_PERIOD_MS;
+    }
+
+    int ready = poll(&pfd, 1, ENABLE_PERIOD_MS);
+    if (ready < 0 && errno != EINTR)
+      break;
+    if (ready <= 0)
+      continue;
+
+    ssize_t n = read(fd, buf + len, sizeof(buf) - len);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+      continue;
+    if (n <= 0)
+      break;
+    len += n;
+    size_t used = process_input(&viewer, buf, len);
+    memmove(buf, buf + used, len - used);
+    len -= used;
+  }
+
+  if (serial)
+    send_command(fd, CMD_DISABLE);
+  if (!viewer.ppm_prefix)
+    restore_terminal(&viewer);
+  if (fd != STDIN_FILENO)
+    close(fd);
+  return viewer.failed ? 1 : 0;
+}